@@ -1,13 +1,20 @@
 #include "Number.h"
+#include "Persistence.h"
+#include "Tuning.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <inttypes.h>
 #include <time.h>
 #include <signal.h>
+#include <string.h>
 
 #define FAIL(...) { fprintf(stderr, __VA_ARGS__); exit(EXIT_FAILURE); }
 
+// The character that should appear at the start of the threshold for the program to only report
+// new records instead of every number that reaches the threshold
+#define RECORDS_CHAR '+'
+
 // If the system has requested that the program be stopped
 static volatile bool StopRequested = false;
 
@@ -45,6 +52,19 @@ static void ReportResult(size_t steps, LargeNumber* number)
     fclose(file);
 }
 
+// Reports a number if it has reached the threshold
+// In record mode, the threshold is raised past every reported number, so that only strict improvements are reported
+// Returns 'true' if the number was reported
+static bool CheckResult(size_t steps, LargeNumber* number, uintmax_t* threshold, bool records)
+{
+    if (steps < *threshold) return false;
+
+    ReportResult(steps, number);
+    if (records) *threshold = steps + 1;
+
+    return true;
+}
+
 // Formats and prints the duration between two points in time to stdout
 static void PrintDiff(time_t start, time_t end)
 {
@@ -69,8 +89,9 @@ static void PrintTimeStats(time_t programStart, time_t deltaStart)
 }
 
 // Reads the program configuration its command-line arguments
-static void ReadArgConfig(int argc, char** argv, uintmax_t* threshold, LargeNumber** start, LargeNumber** end)
+static void ReadArgConfig(int argc, char** argv, uintmax_t* threshold, bool* records, LargeNumber** start, LargeNumber** end, size_t* threads)
 {
+    *records = argv[1][0] == RECORDS_CHAR;
     if (sscanf(argv[1], "%zu", threshold) < 1) 
         FAIL("Invalid threshold %s\n", argv[1]);
     
@@ -87,14 +108,25 @@ static void ReadArgConfig(int argc, char** argv, uintmax_t* threshold, LargeNumb
         *end = SScanNumber(argv[3]);
         if (*end == NULL) FAIL("Invalid end number %s\n", argv[3]);   
     }
+
+    *threads = 1;
+    if (argc >= 5)
+    {
+        if (sscanf(argv[4], "%zu", threads) < 1 || *threads == 0)
+            FAIL("Invalid thread count %s\n", argv[4]);
+    }
 }
 
 // Reads the program configuration from files
-static void ReadFileConfig(uintmax_t* threshold, LargeNumber** start, LargeNumber** end)
+static void ReadFileConfig(uintmax_t* threshold, bool* records, LargeNumber** start, LargeNumber** end, size_t* threads)
 {
     FILE* thresholdFile = fopen("threshold.txt", "r");
     if (thresholdFile == NULL) FAIL("Unable to open threshold.txt\n");
 
+    int first = fgetc(thresholdFile);
+    *records = first == RECORDS_CHAR;
+    if (!*records) ungetc(first, thresholdFile);
+
     if (fscanf(thresholdFile, "%zu", threshold) < 1) FAIL("Invalid threshold number in threshold.txt\n");
     fclose(thresholdFile);
 
@@ -117,6 +149,107 @@ static void ReadFileConfig(uintmax_t* threshold, LargeNumber** start, LargeNumbe
 
         fclose(endFile);
     }
+
+    *threads = 1;
+    FILE* threadsFile = fopen("threads.txt", "r");
+    if (threadsFile != NULL)
+    {
+        if (fscanf(threadsFile, "%zu", threads) < 1 || *threads == 0)
+            FAIL("Invalid thread count in threads.txt\n");
+
+        fclose(threadsFile);
+    }
+}
+
+// Reads the tuning profile from the current working directory, if there is one
+// Returns NULL if there is no profile or if it was measured for a different amount of threads
+static TuningProfile* ReadTuningProfile(size_t threads)
+{
+    FILE* file = fopen("tuning.txt", "r");
+    if (file == NULL) return NULL;
+
+    TuningProfile* profile = FScanTuningProfile(file);
+    fclose(file);
+
+    if (profile == NULL) FAIL("Invalid tuning profile in tuning.txt\n");
+
+    if (profile->Threads != threads)
+    {
+        printf("Ignoring tuning.txt, which was calibrated for %zu threads\n", profile->Threads);
+        FreeTuningProfile(profile);
+        return NULL;
+    }
+
+    return profile;
+}
+
+// Replaces a candidate with the smallest number of the next digit length that could still
+// reach the threshold
+// Returns the candidate unchanged if the program was requested to stop while searching for that length
+static Candidate* SkipDigits(Candidate* candidate, uintmax_t threshold)
+{
+    // The bound never decreases as the digit length grows, so double the length until it is reached,
+    // then binary search for the exact length between the last two tries
+    size_t low = NumberOfDigits(CandidateNumber(candidate));
+    size_t high = low + 1;
+
+    while (PersistenceBound(high) < threshold)
+    {
+        if (StopRequested) return candidate;
+        if (high > SIZE_MAX / 2) FAIL("No digit length can reach %"PRIuMAX" steps\n", threshold);
+
+        low = high;
+        high *= 2;
+    }
+
+    // The bound of 'low' is always below the threshold, and the bound of 'high' is always at or above it
+    while (high - low > 1)
+    {
+        if (StopRequested) return candidate;
+
+        size_t middle = low + (high - low) / 2;
+        if (PersistenceBound(middle) < threshold)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    size_t digits = high;
+
+    printf("\n");
+    printf("No number below %zu digits can reach %"PRIuMAX" steps, skipping ahead\n", digits, threshold);
+
+    FreeCandidate(candidate);
+    return NewCandidate(SmallestWithDigits(digits));
+}
+
+// Measures the strategies available on this machine and writes the results to tuning.txt
+// Arguments are, in order and all optional: 'threads' 'maxDigits'
+static void RunCalibration(int argc, char** argv)
+{
+    size_t threads = 1;
+    if (argc >= 3 && (sscanf(argv[2], "%zu", &threads) < 1 || threads == 0))
+        FAIL("Invalid thread count %s\n", argv[2]);
+
+    size_t maxDigits = DEFAULT_CALIBRATION_DIGITS;
+    if (argc >= 4 && sscanf(argv[3], "%zu", &maxDigits) < 1)
+        FAIL("Invalid digit count %s\n", argv[3]);
+
+    printf("Calibrating for %zu threads up to %zu digits\n", threads, maxDigits);
+
+    TuningProfile* profile = Calibrate(threads, maxDigits, stdout);
+
+    FILE* file = fopen("tuning.txt", "w");
+    if (file == NULL) FAIL("Unable to open tuning.txt\n");
+
+    FPrintTuningProfile(file, profile);
+    fclose(file);
+
+    printf("\n");
+    printf("Wrote tuning.txt:\n");
+    FPrintTuningProfile(stdout, profile);
+
+    FreeTuningProfile(profile);
 }
 
 int main(int argc, char** argv)
@@ -131,15 +264,23 @@ int main(int argc, char** argv)
     signal(SIGTERM, &SignalHandler);
     signal(SIGINT, &SignalHandler);
 
+    if (argc >= 2 && strcmp(argv[1], "calibrate") == 0)
+    {
+        RunCalibration(argc, argv);
+        return EXIT_SUCCESS;
+    }
+
     uintmax_t threshold;
+    bool records;
     LargeNumber* start;
     LargeNumber* end;
+    size_t threads;
 
     bool fromFile = argc <= 1;
     if (fromFile)
-        ReadFileConfig(&threshold, &start, &end);
+        ReadFileConfig(&threshold, &records, &start, &end, &threads);
     else
-        ReadArgConfig(argc, argv, &threshold, &start, &end);
+        ReadArgConfig(argc, argv, &threshold, &records, &start, &end, &threads);
 
     if (start == NULL) start = SmallestWithDigits(1);
 
@@ -155,47 +296,112 @@ int main(int argc, char** argv)
     }
 
     printf("With a minimum of %"PRIuMAX" steps\n", threshold);    
+
+    if (records)
+        printf("Only reporting new records\n");
+
+    if (threads > 1)
+        printf("Using up to %zu threads\n", threads);
     
+    ThreadPool* pool = NewThreadPool(threads);
+    TuningProfile* profile = ReadTuningProfile(threads);
+    if (profile != NULL)
+        printf("Using the strategies in tuning.txt\n");
+
     time_t programStart = time(NULL);
     uintmax_t numbersFound = 0;
 
-    LargeNumber* current = start;
+    Candidate* candidate = NewCandidate(start);
+    LargeNumber* current = CandidateNumber(candidate);
     time_t digitsStart = programStart;
-    bool reportDigits = true;
+    size_t digits = 0;
+
+    // No strategy has been picked yet, so the first one found is always applied
+    Strategy strategy = { 0, 0, 0 };
+    size_t* batchSteps = NULL;
+    LargeNumber** batchNumbers = NULL;
+
+    size_t boundDigits = 0;
+    size_t bound = 0;
     
     while (!StopRequested && (end == NULL || Compare(current, end) <= 0))
     {
-        if (reportDigits)
+        // The bound only depends on the digit length, so it only needs to be recalculated when that changes
+        if (records && NumberOfDigits(current) != boundDigits)
+        {
+            boundDigits = NumberOfDigits(current);
+            bound = PersistenceBound(boundDigits);
+        }
+
+        // No number left in this digit length can beat the current record
+        if (records && bound < threshold)
+        {
+            candidate = SkipDigits(candidate, threshold);
+            current = CandidateNumber(candidate);
+            continue;
+        }
+
+        if (NumberOfDigits(current) != digits)
         {
+            digits = NumberOfDigits(current);
+
             printf("\n");
-            printf("Now at %zu digits\n", NumberOfDigits(current));
+            printf("Now at %zu digits\n", digits);
             PrintTimeStats(programStart, digitsStart);
 
             digitsStart = time(NULL);
-        }
 
-        size_t steps = 0;
-        LargeNumber* acc = CopyNumber(current);
+            Strategy next = FindStrategy(profile, threads, digits);
+            if (next.Batch != strategy.Batch || next.Cutoff != strategy.Cutoff)
+            {
+                if (next.Batch > 1)
+                    printf("Switching to batches of %zu numbers\n", next.Batch);
+                else if (next.Cutoff == NEVER_SPLIT)
+                    printf("Switching to one number at a time, without splitting\n");
+                else
+                    printf("Switching to one number at a time, split above %zu digits\n", next.Cutoff);
+
+                // The numbers of the old batch are only kept around to be reused by the next one
+                for (size_t i = 0; batchNumbers != NULL && i < strategy.Batch; i++)
+                    FreeNumber(batchNumbers[i]);
+
+                free(batchNumbers);
+                batchNumbers = calloc(next.Batch, sizeof(LargeNumber*));
+                batchSteps = realloc(batchSteps, next.Batch * sizeof(size_t));
+            }
+
+            strategy = next;
+        }
 
-        while (NumberOfDigits(acc) > 1)
+        if (strategy.Batch > 1)
         {
-            steps++;
-            LargeNumber* newAcc = MultiplyDigits(acc);
-            FreeNumber(acc);
-            acc = newAcc;
+            size_t count = PersistenceRange(candidate, end, strategy.Batch, batchSteps, batchNumbers, pool);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                if (CheckResult(batchSteps[i], batchNumbers[i], &threshold, records))
+                    numbersFound++;
+            }
+
+            continue;
         }
 
-        FreeNumber(acc);
+        size_t steps = Persistence(current, pool, strategy.Cutoff);
 
-        if (steps >= threshold)
-        {
+        if (CheckResult(steps, current, &threshold, records))
             numbersFound++;
-            ReportResult(steps, current);
-        }
 
-        reportDigits = Increment(current);
+        AdvanceCandidate(candidate);
     }
 
+    for (size_t i = 0; batchNumbers != NULL && i < strategy.Batch; i++)
+        FreeNumber(batchNumbers[i]);
+
+    free(batchSteps);
+    free(batchNumbers);
+    FreeTuningProfile(profile);
+    FreeThreadPool(pool);
+
     if (fromFile)
     {
         FILE* file = fopen("start.txt", "w");
@@ -208,9 +414,24 @@ int main(int argc, char** argv)
             FPrintNumber(file, current);
             fclose(file);
         }
+
+        // Keep the records found so far, so that the search resumes looking for the next one
+        if (records)
+        {
+            file = fopen("threshold.txt", "w");
+            if (file == NULL)
+            {
+                fprintf(stderr, "Unable to open threshold.txt\n");
+            }
+            else
+            {
+                fprintf(file, "%c%"PRIuMAX, RECORDS_CHAR, threshold);
+                fclose(file);
+            }
+        }
     }
 
-    FreeNumber(current);
+    FreeCandidate(candidate);
     FreeNumber(end);
 
     printf("\n");
@@ -114,6 +114,12 @@ LargeNumber* CopyNumber(LargeNumber* number)
     return copy;
 }
 
+void AssignNumber(LargeNumber* target, LargeNumber* source)
+{
+    ResizeNumber(target, source->Size);
+    memcpy(target->Digits, source->Digits, source->Size * sizeof(Digit));
+}
+
 // Makes a large number with the specified numeric value
 static LargeNumber* MakeLarge(uintmax_t value)
 {
@@ -168,6 +174,182 @@ LargeNumber* MultiplyDigits(LargeNumber* number)
     return acc;
 }
 
+// A range of columns of the product of two large numbers, that can be summed independently from the others
+typedef struct ColumnRange
+{
+    // The numbers being multiplied
+    LargeNumber* A;
+    LargeNumber* B;
+
+    // Receives the sum of the digit products of each column, before carrying
+    uint_fast64_t* Columns;
+
+    // The index of the first column in the range
+    size_t Start;
+
+    // The index after the last column in the range
+    size_t End;
+
+} ColumnRange;
+
+// Sums the digit products of a range of columns of the product of two numbers
+// Matches the signature of a thread function so that it can be used as a pool task
+static int SumColumns(void* arg)
+{
+    ColumnRange* range = arg;
+    LargeNumber* a = range->A;
+    LargeNumber* b = range->B;
+
+    for (size_t k = range->Start; k < range->End; k++)
+    {
+        size_t first = k < b->Size ? 0 : k - b->Size + 1;
+        size_t last = k < a->Size ? k : a->Size - 1;
+
+        uint_fast64_t sum = 0;
+        for (size_t i = first; i <= last; i++)
+            sum += (uint_fast32_t)a->Digits[i] * b->Digits[k - i];
+
+        range->Columns[k] = sum;
+    }
+
+    return 0;
+}
+
+// Multiplies two large numbers, resulting in another large number
+// The columns of the product are split into ranges that are summed on a thread pool, then carried sequentially
+// pool: The pool to sum the columns on, or NULL to sum them on the calling thread
+// cutoff: The size, in digits, below which the product is summed on the calling thread
+static LargeNumber* MultiplyNumbers(LargeNumber* a, LargeNumber* b, ThreadPool* pool, size_t cutoff)
+{
+    if (a->Size == 0 || b->Size == 0)
+        return NewNumber(0);
+
+    size_t size = a->Size + b->Size;
+    uint_fast64_t* columns = calloc(size, sizeof(uint_fast64_t));
+
+    // Middle columns take longer to sum than the outer ones, so use a few ranges per thread
+    // and let the pool balance them
+    size_t rangeCount = 1;
+    if (size > cutoff) rangeCount = ThreadPoolSize(pool) * 4;
+    if (rangeCount > size) rangeCount = size;
+
+    ColumnRange* ranges = calloc(rangeCount, sizeof(ColumnRange));
+    PoolTask* tasks = calloc(rangeCount, sizeof(PoolTask));
+
+    for (size_t i = 0; i < rangeCount; i++)
+    {
+        ranges[i] = (ColumnRange){ a, b, columns, size * i / rangeCount, size * (i + 1) / rangeCount };
+        SubmitTask(pool, &tasks[i], &SumColumns, &ranges[i]);
+    }
+
+    for (size_t i = 0; i < rangeCount; i++)
+        WaitTask(pool, &tasks[i]);
+
+    free(tasks);
+    free(ranges);
+
+    LargeNumber* result = NewNumber(size);
+
+    uint_fast64_t carry = 0;
+    for (size_t k = 0; k < size; k++)
+    {
+        uint_fast64_t value = columns[k] + carry;
+        carry = value / BASE;
+        result->Digits[k] = value % BASE;
+    }
+
+    free(columns);
+
+    TrimNumber(result);
+    return result;
+}
+
+// Multiplies the digits of a number between two indexes, sequentially
+// start: The index of the first digit to multiply
+// end: The index after the last digit to multiply
+static LargeNumber* MultiplyDigitRange(LargeNumber* number, size_t start, size_t end)
+{
+    LargeNumber* acc = MakeLarge(GetDigit(number, start));
+
+    for (size_t i = start + 1; i < end; i++)
+        Multiply(acc, GetDigit(number, i));
+
+    TrimNumber(acc);
+    return acc;
+}
+
+// A node of the product tree used to multiply the digits of a number in parallel
+typedef struct ProductTreeNode
+{
+    // The number whose digits are being multiplied
+    LargeNumber* Number;
+
+    // The index of the first digit covered by this node
+    size_t Start;
+
+    // The index after the last digit covered by this node
+    size_t End;
+
+    // The pool that subtrees and combinations are run on
+    ThreadPool* Pool;
+
+    // The size, in digits, below which a node is evaluated sequentially
+    size_t Cutoff;
+
+    // The product of all digits covered by this node, set once it has been evaluated
+    LargeNumber* Result;
+
+} ProductTreeNode;
+
+// Evaluates a node of the product tree, storing the product of its digits in its result
+// Matches the signature of a thread function so that it can be used as a pool task
+static int EvaluateProductTree(void* arg)
+{
+    ProductTreeNode* node = arg;
+    size_t length = node->End - node->Start;
+
+    if (length <= node->Cutoff)
+    {
+        node->Result = MultiplyDigitRange(node->Number, node->Start, node->End);
+        return 0;
+    }
+
+    size_t middle = node->Start + length / 2;
+
+    ProductTreeNode left = { node->Number, node->Start, middle, node->Pool, node->Cutoff, NULL };
+    ProductTreeNode right = { node->Number, middle, node->End, node->Pool, node->Cutoff, NULL };
+
+    // Let another thread of the pool pick up the left half while we evaluate the right one
+    PoolTask task;
+    SubmitTask(node->Pool, &task, &EvaluateProductTree, &left);
+    EvaluateProductTree(&right);
+    WaitTask(node->Pool, &task);
+
+    node->Result = MultiplyNumbers(left.Result, right.Result, node->Pool, node->Cutoff);
+    FreeNumber(left.Result);
+    FreeNumber(right.Result);
+    return 0;
+}
+
+LargeNumber* MultiplyDigitsParallel(LargeNumber* number, ThreadPool* pool, size_t cutoff)
+{
+    if (cutoff == 0) cutoff = 1;
+
+    if (number->Size <= cutoff)
+        return MultiplyDigits(number);
+
+    ProductTreeNode root = { number, 0, number->Size, pool, cutoff, NULL };
+    EvaluateProductTree(&root);
+    return root.Result;
+}
+
+size_t MaxDigitProductDigits(size_t digits)
+{
+    // The biggest possible product is (BASE - 1)^digits, which has floor(digits * log(BASE - 1) / log(BASE)) + 1 digits
+    // One extra digit is added to stay on the safe side of any floating point rounding
+    return (size_t)floor((double)digits * log(BASE - 1) / log(BASE)) + 2;
+}
+
 int8_t Compare(LargeNumber* a, LargeNumber* b)
 {
     if (a->Size > b->Size) return 1;
@@ -506,3 +688,213 @@ bool Increment(LargeNumber* number)
         exit(EXIT_FAILURE);
     }
 }
+
+struct Candidate
+{
+    // The number this candidate represents
+    LargeNumber* Number;
+
+    // If the state below describes the current number
+    // This is only false if the number isn't part of the search space, in which case
+    // the candidate falls back to Increment until it reaches a number that is
+    bool Tracked;
+
+    // The prefix of the number
+    NumberPrefix Prefix;
+
+    // The amount of 9s at the end of the regular part of the number
+    size_t Nines;
+
+    // The amount of 8s right before the 9s of the regular part of the number
+    // Every other digit of the regular part of the number is a 7
+    size_t Eights;
+
+    // The digits that were changed by the last advance
+    DigitRange Changed;
+};
+
+// Rebuilds the state of a candidate from its number
+// Returns 'false' if the number isn't part of the search space and couldn't be tracked
+static bool TrackCandidate(Candidate* candidate)
+{
+    LargeNumber* number = candidate->Number;
+    if (number->Size == 0) return false;
+
+    candidate->Prefix = FindPrefix(number);
+    size_t regular = number->Size - candidate->Prefix.Length;
+
+    size_t i = 0;
+    while (i < regular && GetDigit(number, i) == 9) i++;
+    candidate->Nines = i;
+
+    while (i < regular && GetDigit(number, i) == 8) i++;
+    candidate->Eights = i - candidate->Nines;
+
+    while (i < regular && GetDigit(number, i) == 7) i++;
+    return i == regular;
+}
+
+Candidate* NewCandidate(LargeNumber* number)
+{
+    Candidate* candidate = malloc(sizeof(Candidate));
+    candidate->Number = number;
+    candidate->Tracked = TrackCandidate(candidate);
+    candidate->Changed.Start = 0;
+    candidate->Changed.End = number->Size;
+    return candidate;
+}
+
+void FreeCandidate(Candidate* candidate)
+{
+    if (candidate == NULL) return;
+    FreeNumber(candidate->Number);
+    free(candidate);
+}
+
+LargeNumber* CandidateNumber(Candidate* candidate)
+{
+    return candidate->Number;
+}
+
+DigitRange ChangedDigits(Candidate* candidate)
+{
+    return candidate->Changed;
+}
+
+bool AdvanceCandidate(Candidate* candidate)
+{
+    LargeNumber* number = candidate->Number;
+
+    if (!candidate->Tracked)
+    {
+        bool increased = Increment(number);
+        candidate->Changed.Start = 0;
+        candidate->Changed.End = number->Size;
+        candidate->Tracked = TrackCandidate(candidate);
+        return increased;
+    }
+
+    size_t size = number->Size;
+    size_t regular = size - candidate->Prefix.Length;
+
+    // The regular part of the number can still be increased, so only the digit right before
+    // the 9s (the "border") and possibly the 9s themselves need to change
+    if (candidate->Nines < regular)
+    {
+        size_t border = candidate->Nines;
+
+        if (candidate->Eights > 0) // 7889 -> 7899
+        {
+            SetDigit(number, border, 9);
+            candidate->Nines++;
+            candidate->Eights--;
+            candidate->Changed.Start = border;
+        }
+        else // 7799 -> 7888
+        {
+            for (size_t i = 0; i <= border; i++)
+                SetDigit(number, i, 8);
+
+            candidate->Eights = candidate->Nines + 1;
+            candidate->Nines = 0;
+            candidate->Changed.Start = 0;
+        }
+
+        candidate->Changed.End = border + 1;
+        return false;
+    }
+
+    // The regular part of the number has overflowed and can no longer increase
+    // Reset it to all 7s and move to the next bigger prefix, as Increment does
+
+    for (size_t i = 0; i < regular; i++)
+        SetDigit(number, i, 7);
+
+    candidate->Nines = 0;
+    candidate->Eights = 0;
+    candidate->Changed.Start = 0;
+
+    NumberPrefix* prefix = &candidate->Prefix;
+    switch (prefix->Type)
+    {
+    case PREFIX_26: // 2699... -> 2777...
+        SetDigit(number, size - 2, 7);
+        prefix->Length = 1;
+        prefix->Type = PREFIX_2;
+        candidate->Changed.End = size - 1;
+        return false;
+
+    case PREFIX_2: // 2999... -> 3577...
+        SetDigit(number, size - 1, 3);
+        if (size >= 2)
+        {
+            SetDigit(number, size - 2, 5);
+            prefix->Length = 2;
+            prefix->Type = PREFIX_35;
+        }
+        else
+        {
+            prefix->Type = PREFIX_3;
+        }
+
+        candidate->Changed.End = size;
+        return false;
+
+    case PREFIX_35: // 3599... -> 3777...
+        SetDigit(number, size - 2, 7);
+        prefix->Length = 1;
+        prefix->Type = PREFIX_3;
+        candidate->Changed.End = size - 1;
+        return false;
+
+    case PREFIX_3: // 3999... -> 4777...
+        SetDigit(number, size - 1, 4);
+        prefix->Type = PREFIX_4;
+        candidate->Changed.End = size;
+        return false;
+
+    case PREFIX_4: // 4999... -> 5555...
+        for (size_t i = 0; i < size; i++)
+            SetDigit(number, i, 5);
+
+        prefix->Length = size;
+        prefix->Type = PREFIX_5s;
+        candidate->Changed.End = size;
+        return false;
+
+    case PREFIX_5s:
+        if (prefix->Length == 1) // 5999... -> 6777...
+        {
+            SetDigit(number, size - 1, 6);
+            prefix->Type = PREFIX_6;
+            candidate->Changed.End = size;
+        }
+        else // 5559... -> 5577...
+        {
+            SetDigit(number, size - prefix->Length, 7);
+            candidate->Changed.End = size - prefix->Length + 1;
+            prefix->Length--;
+        }
+
+        return false;
+
+    case PREFIX_6: // 6999... -> 7777...
+        SetDigit(number, size - 1, 7);
+        prefix->Length = 0;
+        prefix->Type = PREFIX_NONE;
+        candidate->Changed.End = size;
+        return false;
+
+    case PREFIX_NONE: // 9999... -> 26777...
+        SetDigit(number, size - 1, 6);
+        SetDigit(number, size, 2);
+        prefix->Length = 2;
+        prefix->Type = PREFIX_26;
+        candidate->Changed.End = size + 1;
+        return true;
+
+    default:
+        fprintf(stderr, "FATAL ERROR");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ThreadPool.h"
+
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -18,13 +20,66 @@ void FreeNumber(LargeNumber* number);
 // Makes a copy of a number
 LargeNumber* CopyNumber(LargeNumber* number);
 
+// Copies the value of a number into another, reusing the memory of the target when possible
+void AssignNumber(LargeNumber* target, LargeNumber* source);
+
 // Advances a large number in-place to the next number in the search space
 // Returns 'true' if the amount of digits of the number was increased
 bool Increment(LargeNumber* number);
 
+// A number of the search space that keeps track of its own structure, so that it can
+// be advanced to the next number of the search space by changing only the digits that differ
+typedef struct Candidate Candidate;
+
+// A range of digit positions of a large number, counted from its least significant digit
+typedef struct DigitRange
+{
+    // The position of the first digit in the range
+    size_t Start;
+
+    // The position after the last digit in the range
+    size_t End;
+
+} DigitRange;
+
+// Creates a candidate that starts at the specified number
+// The candidate takes ownership of the number, which will be freed along with it
+Candidate* NewCandidate(LargeNumber* number);
+
+// Frees the memory used by a candidate and its number
+void FreeCandidate(Candidate* candidate);
+
+// Gets the number that a candidate currently represents
+// The number is owned by the candidate and must not be modified or freed
+LargeNumber* CandidateNumber(Candidate* candidate);
+
+// Advances a candidate to the next number in the search space, with the same results as Increment
+// Runs in amortized constant time, as long as the candidate started inside the search space
+// Returns 'true' if the amount of digits of the number was increased
+bool AdvanceCandidate(Candidate* candidate);
+
+// Gets the range of digits that were changed by the last advance of a candidate
+// Every digit outside this range is guaranteed to be the same as before the advance
+DigitRange ChangedDigits(Candidate* candidate);
+
 // Multiplies the digits of a large number, resulting in another large number
 LargeNumber* MultiplyDigits(LargeNumber* number);
 
+// The default size, in digits, below which MultiplyDigitsParallel stops splitting a number
+// and multiplies its digits sequentially
+#define DEFAULT_PARALLEL_CUTOFF 4096
+
+// Multiplies the digits of a large number, resulting in another large number
+// The digits are split into a balanced product tree down to the cutoff, and subtrees are multiplied
+// and combined on a thread pool. Falls back to MultiplyDigits if the number isn't bigger than the cutoff.
+// pool: The pool to run subtrees on, or NULL to evaluate the whole tree on the calling thread
+// cutoff: The size, in digits, below which a subtree is multiplied sequentially
+LargeNumber* MultiplyDigitsParallel(LargeNumber* number, ThreadPool* pool, size_t cutoff);
+
+// Gets an upper bound for the amount of digits of the product of the digits of any number
+// that has the specified number of digits
+size_t MaxDigitProductDigits(size_t digits);
+
 // Compares two large numbers
 // Returns -1 if a is smaller than b
 // Returns 0 if a is equal to b
@@ -0,0 +1,162 @@
+#include "Persistence.h"
+#include "Threading.h"
+
+#include <stdlib.h>
+
+size_t Persistence(LargeNumber* number, ThreadPool* pool, size_t cutoff)
+{
+    if (NumberOfDigits(number) <= 1) return 0;
+
+    // The first product is made straight from the number, so it never has to be copied
+    size_t steps = 1;
+    LargeNumber* acc = MultiplyDigitsParallel(number, pool, cutoff);
+
+    while (NumberOfDigits(acc) > 1)
+    {
+        steps++;
+        LargeNumber* newAcc = MultiplyDigitsParallel(acc, pool, cutoff);
+        FreeNumber(acc);
+        acc = newAcc;
+    }
+
+    FreeNumber(acc);
+    return steps;
+}
+
+// The work shared between all threads of a batch
+typedef struct BatchWork
+{
+    // The numbers to calculate the persistence of
+    LargeNumber** Numbers;
+
+    // The amount of numbers
+    size_t Count;
+
+    // Receives the persistence of each number
+    size_t* Steps;
+
+    // The index of the next number that hasn't been picked up by any thread yet
+    size_t Next;
+
+    // Protects the index of the next number
+    Mutex Lock;
+
+} BatchWork;
+
+// Calculates the persistence of numbers from a batch until there are none left
+// Matches the signature of a thread function so that it can be used as a pool task
+static int RunBatch(void* arg)
+{
+    BatchWork* work = arg;
+
+    while (true)
+    {
+        LockMutex(&work->Lock);
+        size_t i = work->Next++;
+        UnlockMutex(&work->Lock);
+
+        if (i >= work->Count) return 0;
+        work->Steps[i] = Persistence(work->Numbers[i], NULL, DEFAULT_PARALLEL_CUTOFF);
+    }
+}
+
+// The most workers of a pool a single batch will use, besides the calling thread
+// Keeps the tasks of a batch on the stack, since there is never a reason to have more tasks than threads
+#define MAX_BATCH_TASKS 256
+
+void PersistenceBatch(LargeNumber** numbers, size_t count, size_t* steps, ThreadPool* pool)
+{
+    BatchWork work = { numbers, count, steps, 0 };
+    InitMutex(&work.Lock);
+
+    size_t taskCount = ThreadPoolSize(pool) - 1;
+    if (taskCount > MAX_BATCH_TASKS) taskCount = MAX_BATCH_TASKS;
+    if (taskCount + 1 > count) taskCount = count > 0 ? count - 1 : 0;
+
+    // Every task and the calling thread take numbers from the batch until there are none left
+    PoolTask tasks[MAX_BATCH_TASKS];
+    for (size_t i = 0; i < taskCount; i++)
+        SubmitTask(pool, &tasks[i], &RunBatch, &work);
+
+    RunBatch(&work);
+
+    for (size_t i = 0; i < taskCount; i++)
+        WaitTask(pool, &tasks[i]);
+
+    DestroyMutex(&work.Lock);
+}
+
+size_t PersistenceRange(Candidate* candidate, LargeNumber* end, size_t count, size_t* steps, LargeNumber** numbers, ThreadPool* pool)
+{
+    size_t found = 0;
+    while (found < count && (end == NULL || Compare(CandidateNumber(candidate), end) <= 0))
+    {
+        if (numbers[found] == NULL)
+            numbers[found] = CopyNumber(CandidateNumber(candidate));
+        else
+            AssignNumber(numbers[found], CandidateNumber(candidate));
+
+        found++;
+        if (AdvanceCandidate(candidate)) break;
+    }
+
+    PersistenceBatch(numbers, found, steps, pool);
+    return found;
+}
+
+// Every digit length below this one has its persistence bound calculated exhaustively
+// Starting at this length, multiplying the digits of a number is guaranteed to shorten it
+static size_t ExhaustiveDigits;
+
+// The exact maximum persistence of all numbers with up to each amount of digits below ExhaustiveDigits
+static size_t* ExhaustiveBounds;
+
+// Ensures the exhaustive bounds are calculated only once, even across threads
+static OnceFlag ExhaustiveBoundsFlag = ONCE_FLAG_INITIALIZER;
+
+// Calculates the exact maximum persistence for every digit length below ExhaustiveDigits
+// It is enough to go through the search space: the maximum persistence of a digit length is always reached
+// by a record holder (the smallest number with that persistence), which can't be longer than any other number
+// with the same persistence, and the search space contains every record holder from persistence 3 onwards
+// The only record holders it misses, 10 and 25, have two digits, like 77, which reaches a higher persistence
+static void CalculateExhaustiveBounds(void)
+{
+    ExhaustiveDigits = 1;
+    while (MaxDigitProductDigits(ExhaustiveDigits) >= ExhaustiveDigits)
+        ExhaustiveDigits++;
+
+    ExhaustiveBounds = calloc(ExhaustiveDigits, sizeof(size_t));
+
+    Candidate* candidate = NewCandidate(SmallestWithDigits(1));
+    size_t max = 0;
+
+    for (size_t digits = 1; digits < ExhaustiveDigits; digits++)
+    {
+        while (NumberOfDigits(CandidateNumber(candidate)) == digits)
+        {
+            size_t steps = Persistence(CandidateNumber(candidate), NULL, DEFAULT_PARALLEL_CUTOFF);
+            if (steps > max) max = steps;
+
+            AdvanceCandidate(candidate);
+        }
+
+        ExhaustiveBounds[digits] = max;
+    }
+
+    FreeCandidate(candidate);
+}
+
+size_t PersistenceBound(size_t digits)
+{
+    CallOnce(&ExhaustiveBoundsFlag, &CalculateExhaustiveBounds);
+
+    // Every multiplication of the digits of a long number takes one step and leaves a shorter number
+    size_t steps = 0;
+    while (digits >= ExhaustiveDigits)
+    {
+        digits = MaxDigitProductDigits(digits);
+        steps++;
+    }
+
+    return steps + ExhaustiveBounds[digits];
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Number.h"
+
+#include <stddef.h>
+
+// Calculates the multiplicative persistence of a number: the amount of times its digits have to be
+// multiplied until a single-digit number is reached
+// pool: The pool used to multiply the digits of the number, or NULL to only use the calling thread
+// cutoff: The size, in digits, below which the digits are multiplied sequentially (see MultiplyDigitsParallel)
+size_t Persistence(LargeNumber* number, ThreadPool* pool, size_t cutoff);
+
+// Calculates the multiplicative persistence of several numbers at once
+// numbers: The numbers to calculate the persistence of
+// count: The amount of numbers
+// steps: Buffer with space for 'count' items, receives the persistence of each number
+// pool: The pool to spread the numbers across, or NULL to only use the calling thread
+void PersistenceBatch(LargeNumber** numbers, size_t count, size_t* steps, ThreadPool* pool);
+
+// Calculates the multiplicative persistence of consecutive numbers of the search space, starting at
+// the current number of a candidate, and advances the candidate past the numbers that were calculated
+// Never calculates numbers of different digit lengths in a single call, so that callers can react to a
+// change in the amount of digits between calls
+// Returns how many numbers were calculated, which is only less than 'count' if 'end' was passed or if
+// the amount of digits of the candidate increased
+// candidate: The candidate to start at
+// end: The last number to calculate, or NULL to always calculate 'count' numbers
+// count: The maximum amount of numbers to calculate
+// steps: Buffer with space for 'count' items, receives the persistence of each number
+// numbers: Buffer with space for 'count' items, receives a copy of each number that was calculated
+//   Items must start as NULL, and the numbers left in them are reused by the next call with the same buffer,
+//   so that no memory is allocated once the buffer is warmed up. The caller frees them when done with the buffer.
+// pool: The pool to spread the numbers across, or NULL to only use the calling thread
+size_t PersistenceRange(Candidate* candidate, LargeNumber* end, size_t count, size_t* steps, LargeNumber** numbers, ThreadPool* pool);
+
+// Gets an upper bound for the multiplicative persistence of every number with up to the specified
+// number of digits
+// Short digit lengths get the exact maximum, found by calculating every number of the search space
+// the first time this is called. Longer ones build on that, since multiplying the digits of a number
+// always produces a number with fewer digits once there are enough of them.
+size_t PersistenceBound(size_t digits);
@@ -0,0 +1,145 @@
+#include "ThreadPool.h"
+#include "Threading.h"
+
+#include <stdlib.h>
+
+struct ThreadPool
+{
+    // The worker threads of the pool
+    Thread* Workers;
+
+    // The amount of worker threads that were started
+    size_t WorkerCount;
+
+    // Protects every field below, along with the 'Done' flag of queued tasks
+    Mutex Lock;
+
+    // Signaled whenever a task is queued, a task finishes, or the pool is stopping
+    Condition Changed;
+
+    // The tasks waiting to be run, most recently queued first
+    PoolTask* Queue;
+
+    // If the workers should exit once the queue is empty
+    bool Stopping;
+};
+
+// Takes the next task from the queue of a pool, runs it and marks it as done
+// Must be called with the lock held and a non-empty queue; the lock is released while the task runs
+static void RunNextTask(ThreadPool* pool)
+{
+    PoolTask* task = pool->Queue;
+    pool->Queue = task->Next;
+
+    UnlockMutex(&pool->Lock);
+    task->Function(task->Argument);
+    LockMutex(&pool->Lock);
+
+    task->Done = true;
+    BroadcastCondition(&pool->Changed);
+}
+
+// Runs the tasks of a pool until it is stopped
+// Matches the signature of a thread function so that it can be used as one
+static int RunWorker(void* arg)
+{
+    ThreadPool* pool = arg;
+
+    LockMutex(&pool->Lock);
+
+    while (true)
+    {
+        if (pool->Queue != NULL)
+            RunNextTask(pool);
+        else if (pool->Stopping)
+            break;
+        else
+            WaitCondition(&pool->Changed, &pool->Lock);
+    }
+
+    UnlockMutex(&pool->Lock);
+    return 0;
+}
+
+ThreadPool* NewThreadPool(size_t threads)
+{
+    ThreadPool* pool = malloc(sizeof(ThreadPool));
+    pool->WorkerCount = 0;
+    pool->Workers = NULL;
+    pool->Queue = NULL;
+    pool->Stopping = false;
+
+    InitMutex(&pool->Lock);
+    InitCondition(&pool->Changed);
+
+    if (threads <= 1) return pool;
+
+    // If the system runs out of threads, make do with the ones we could get
+    pool->Workers = calloc(threads - 1, sizeof(Thread));
+    while (pool->WorkerCount < threads - 1 && StartThread(&pool->Workers[pool->WorkerCount], &RunWorker, pool))
+        pool->WorkerCount++;
+
+    return pool;
+}
+
+void FreeThreadPool(ThreadPool* pool)
+{
+    if (pool == NULL) return;
+
+    LockMutex(&pool->Lock);
+    pool->Stopping = true;
+    BroadcastCondition(&pool->Changed);
+    UnlockMutex(&pool->Lock);
+
+    for (size_t i = 0; i < pool->WorkerCount; i++)
+        JoinThread(pool->Workers[i]);
+
+    DestroyCondition(&pool->Changed);
+    DestroyMutex(&pool->Lock);
+    free(pool->Workers);
+    free(pool);
+}
+
+size_t ThreadPoolSize(ThreadPool* pool)
+{
+    if (pool == NULL) return 1;
+    return pool->WorkerCount + 1;
+}
+
+void SubmitTask(ThreadPool* pool, PoolTask* task, int (*function)(void*), void* argument)
+{
+    task->Function = function;
+    task->Argument = argument;
+    task->Done = false;
+    task->Next = NULL;
+
+    if (pool == NULL || pool->WorkerCount == 0)
+    {
+        function(argument);
+        task->Done = true;
+        return;
+    }
+
+    LockMutex(&pool->Lock);
+    task->Next = pool->Queue;
+    pool->Queue = task;
+    BroadcastCondition(&pool->Changed);
+    UnlockMutex(&pool->Lock);
+}
+
+void WaitTask(ThreadPool* pool, PoolTask* task)
+{
+    if (pool == NULL || pool->WorkerCount == 0) return;
+
+    LockMutex(&pool->Lock);
+
+    while (!task->Done)
+    {
+        if (pool->Queue != NULL)
+            RunNextTask(pool);
+        else
+            WaitCondition(&pool->Changed, &pool->Lock);
+    }
+
+    UnlockMutex(&pool->Lock);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A set of worker threads that are started once and then reused to run tasks
+typedef struct ThreadPool ThreadPool;
+
+// A unit of work that can be run on a thread pool
+// Owned by whoever submits it, and must stay alive until it has been waited for
+typedef struct PoolTask
+{
+    // The function to run
+    int (*Function)(void*);
+
+    // The argument to pass to the function
+    void* Argument;
+
+    // If the function has finished running
+    bool Done;
+
+    // The next task in the queue of the pool
+    struct PoolTask* Next;
+
+} PoolTask;
+
+// Creates a thread pool
+// threads: The amount of threads that will run tasks, including any thread that waits for a task
+//   A pool of 1 thread has no workers and runs every task right away on the submitting thread
+ThreadPool* NewThreadPool(size_t threads);
+
+// Stops the workers of a thread pool and frees its memory
+// Every submitted task must have been waited for
+void FreeThreadPool(ThreadPool* pool);
+
+// Gets the amount of threads that run the tasks of a pool, including any thread that waits for a task
+// Returns 1 if the pool is NULL
+size_t ThreadPoolSize(ThreadPool* pool);
+
+// Queues a task to be run by a thread pool
+// If the pool is NULL or has no workers, the task is run right away
+void SubmitTask(ThreadPool* pool, PoolTask* task, int (*function)(void*), void* argument);
+
+// Waits for a task to finish running
+// While waiting, the calling thread runs other queued tasks, so tasks can safely submit and wait for other tasks
+void WaitTask(ThreadPool* pool, PoolTask* task);
@@ -0,0 +1,107 @@
+#include "Threading.h"
+
+#include <stdlib.h>
+
+// The function and argument that a new thread should run
+// Needed because the platform thread functions have a different signature than ours
+typedef struct ThreadStart
+{
+    // The function to run
+    int (*Function)(void*);
+
+    // The argument to pass to the function
+    void* Argument;
+
+} ThreadStart;
+
+#ifdef _WIN32
+
+// Runs the function of a new thread
+static DWORD WINAPI RunThread(LPVOID arg)
+{
+    ThreadStart start = *(ThreadStart*)arg;
+    free(arg);
+    return (DWORD)start.Function(start.Argument);
+}
+
+bool StartThread(Thread* thread, int (*function)(void*), void* argument)
+{
+    ThreadStart* start = malloc(sizeof(ThreadStart));
+    start->Function = function;
+    start->Argument = argument;
+
+    *thread = CreateThread(NULL, 0, &RunThread, start, 0, NULL);
+    if (*thread != NULL) return true;
+
+    free(start);
+    return false;
+}
+
+void JoinThread(Thread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+void InitMutex(Mutex* mutex) { InitializeSRWLock(mutex); }
+void DestroyMutex(Mutex* mutex) { (void)mutex; }
+void LockMutex(Mutex* mutex) { AcquireSRWLockExclusive(mutex); }
+void UnlockMutex(Mutex* mutex) { ReleaseSRWLockExclusive(mutex); }
+
+void InitCondition(Condition* condition) { InitializeConditionVariable(condition); }
+void DestroyCondition(Condition* condition) { (void)condition; }
+void WaitCondition(Condition* condition, Mutex* mutex) { SleepConditionVariableSRW(condition, mutex, INFINITE, 0); }
+void BroadcastCondition(Condition* condition) { WakeAllConditionVariable(condition); }
+
+// Runs the function of a once flag
+static BOOL CALLBACK RunOnce(PINIT_ONCE flag, PVOID parameter, PVOID* context)
+{
+    (void)flag;
+    (void)context;
+    (*(void (**)(void))parameter)();
+    return TRUE;
+}
+
+void CallOnce(OnceFlag* flag, void (*function)(void))
+{
+    InitOnceExecuteOnce(flag, &RunOnce, &function, NULL);
+}
+
+#else
+
+// Runs the function of a new thread
+static void* RunThread(void* arg)
+{
+    ThreadStart start = *(ThreadStart*)arg;
+    free(arg);
+    start.Function(start.Argument);
+    return NULL;
+}
+
+bool StartThread(Thread* thread, int (*function)(void*), void* argument)
+{
+    ThreadStart* start = malloc(sizeof(ThreadStart));
+    start->Function = function;
+    start->Argument = argument;
+
+    if (pthread_create(thread, NULL, &RunThread, start) == 0) return true;
+
+    free(start);
+    return false;
+}
+
+void JoinThread(Thread thread) { pthread_join(thread, NULL); }
+
+void InitMutex(Mutex* mutex) { pthread_mutex_init(mutex, NULL); }
+void DestroyMutex(Mutex* mutex) { pthread_mutex_destroy(mutex); }
+void LockMutex(Mutex* mutex) { pthread_mutex_lock(mutex); }
+void UnlockMutex(Mutex* mutex) { pthread_mutex_unlock(mutex); }
+
+void InitCondition(Condition* condition) { pthread_cond_init(condition, NULL); }
+void DestroyCondition(Condition* condition) { pthread_cond_destroy(condition); }
+void WaitCondition(Condition* condition, Mutex* mutex) { pthread_cond_wait(condition, mutex); }
+void BroadcastCondition(Condition* condition) { pthread_cond_broadcast(condition); }
+
+void CallOnce(OnceFlag* flag, void (*function)(void)) { pthread_once(flag, function); }
+
+#endif
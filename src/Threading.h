@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdbool.h>
+
+// A thin layer over the threading primitives of the platform: Win32 threads on Windows, and POSIX threads
+// everywhere else. C11 <threads.h> isn't used because neither MSVC nor Apple's libc reliably provide it.
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef HANDLE Thread;
+typedef SRWLOCK Mutex;
+typedef CONDITION_VARIABLE Condition;
+typedef INIT_ONCE OnceFlag;
+
+#define ONCE_FLAG_INITIALIZER INIT_ONCE_STATIC_INIT
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Condition;
+typedef pthread_once_t OnceFlag;
+
+#define ONCE_FLAG_INITIALIZER PTHREAD_ONCE_INIT
+
+#endif
+
+// Starts a new thread that runs a function
+// Returns 'false' if the thread couldn't be started
+bool StartThread(Thread* thread, int (*function)(void*), void* argument);
+
+// Waits for a thread to finish and releases it
+void JoinThread(Thread thread);
+
+// Initializes a mutex
+void InitMutex(Mutex* mutex);
+
+// Releases the resources used by a mutex
+void DestroyMutex(Mutex* mutex);
+
+// Locks a mutex, waiting for it to be unlocked if needed
+void LockMutex(Mutex* mutex);
+
+// Unlocks a mutex
+void UnlockMutex(Mutex* mutex);
+
+// Initializes a condition variable
+void InitCondition(Condition* condition);
+
+// Releases the resources used by a condition variable
+void DestroyCondition(Condition* condition);
+
+// Unlocks a mutex and waits for a condition variable to be signaled, then locks the mutex again
+void WaitCondition(Condition* condition, Mutex* mutex);
+
+// Wakes up every thread waiting on a condition variable
+void BroadcastCondition(Condition* condition);
+
+// Runs a function exactly once for a flag, even when called from several threads at the same time
+// The flag must be initialized with ONCE_FLAG_INITIALIZER
+void CallOnce(OnceFlag* flag, void (*function)(void));
@@ -0,0 +1,256 @@
+#include "Tuning.h"
+#include "Number.h"
+#include "Persistence.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The smallest digit length measured when calibrating
+#define CALIBRATION_START_DIGITS 16
+
+// For how long, in seconds, each strategy is measured at each digit length
+#define CALIBRATION_SECONDS 0.1
+
+// The smallest product tree cutoff that will be measured, in digits
+// Anything smaller spends more time combining subtrees than multiplying digits
+#define CALIBRATION_MIN_CUTOFF 64
+
+// How many numbers per thread the default strategy puts in each batch
+// A few per thread keeps every thread busy even when some numbers take longer than others
+#define DEFAULT_BATCH_PER_THREAD 4
+
+Strategy DefaultStrategy(size_t threads, size_t digits)
+{
+    if (threads > 1 && digits <= DEFAULT_PARALLEL_CUTOFF)
+        return (Strategy){ 1, DEFAULT_BATCH_PER_THREAD * threads, DEFAULT_PARALLEL_CUTOFF };
+
+    return (Strategy){ threads > 1 ? DEFAULT_PARALLEL_CUTOFF + 1 : 1, 1, DEFAULT_PARALLEL_CUTOFF };
+}
+
+// Writes the cutoff of a strategy to a stream
+static void FPrintCutoff(FILE* file, size_t cutoff)
+{
+    if (cutoff == NEVER_SPLIT)
+        fputs(NEVER_SPLIT_TEXT, file);
+    else
+        fprintf(file, "%zu", cutoff);
+}
+
+// Gets the current wall clock time in seconds
+// CPU time can't be used, as it would add up the time of all threads
+static double Now(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Measures how long a strategy takes to calculate each number of a digit length, in seconds
+static double Measure(Strategy strategy, size_t digits, ThreadPool* pool)
+{
+    Candidate* candidate = NewCandidate(SmallestWithDigits(digits));
+    size_t* steps = calloc(strategy.Batch, sizeof(size_t));
+    LargeNumber** numbers = calloc(strategy.Batch, sizeof(LargeNumber*));
+
+    size_t count = 0;
+    double start = Now();
+    double elapsed;
+
+    do
+    {
+        bool increased;
+
+        if (strategy.Batch > 1)
+        {
+            size_t found = PersistenceRange(candidate, NULL, strategy.Batch, steps, numbers, pool);
+            increased = found < strategy.Batch;
+            count += found;
+        }
+        else
+        {
+            Persistence(CandidateNumber(candidate), pool, strategy.Cutoff);
+            increased = AdvanceCandidate(candidate);
+            count++;
+        }
+
+        // Short digit lengths run out of numbers before the time is up, so start over to avoid
+        // measuring longer numbers along with them
+        if (increased)
+        {
+            FreeCandidate(candidate);
+            candidate = NewCandidate(SmallestWithDigits(digits));
+        }
+
+        elapsed = Now() - start;
+    } while (elapsed < CALIBRATION_SECONDS);
+
+    for (size_t i = 0; i < strategy.Batch; i++)
+        FreeNumber(numbers[i]);
+
+    free(numbers);
+    free(steps);
+    FreeCandidate(candidate);
+    return elapsed / count;
+}
+
+// Adds a strategy to the end of a profile, merging it with the last one if they are the same
+static void AddStrategy(TuningProfile* profile, Strategy strategy)
+{
+    if (profile->Count > 0)
+    {
+        Strategy* last = &profile->Strategies[profile->Count - 1];
+        if (last->Batch == strategy.Batch && last->Cutoff == strategy.Cutoff)
+            return;
+    }
+
+    profile->Strategies = realloc(profile->Strategies, (profile->Count + 1) * sizeof(Strategy));
+    profile->Strategies[profile->Count++] = strategy;
+}
+
+TuningProfile* Calibrate(size_t threads, size_t maxDigits, FILE* log)
+{
+    if (threads == 0) threads = 1;
+
+    TuningProfile* profile = malloc(sizeof(TuningProfile));
+    profile->Threads = threads;
+    profile->Count = 0;
+    profile->Strategies = NULL;
+
+    ThreadPool* pool = NewThreadPool(threads);
+
+    for (size_t digits = CALIBRATION_START_DIGITS; digits <= maxDigits; digits *= 2)
+    {
+        // Calculating one number at a time without splitting it is always available
+        Strategy options[8];
+        size_t optionCount = 0;
+        options[optionCount++] = (Strategy){ digits, 1, NEVER_SPLIT };
+
+        // Split each number into a product tree with increasingly small subtrees
+        // This pays off even on a single thread, as combining subtrees is cheaper than multiplying digit by digit
+        size_t cutoffs[] = { DEFAULT_PARALLEL_CUTOFF, digits / 2, digits / threads, digits / (4 * threads) };
+        for (size_t i = 0; i < sizeof(cutoffs) / sizeof(cutoffs[0]); i++)
+        {
+            if (cutoffs[i] < CALIBRATION_MIN_CUTOFF || cutoffs[i] >= digits) continue;
+
+            bool measured = false;
+            for (size_t j = 0; j < optionCount; j++)
+                measured |= options[j].Cutoff == cutoffs[i];
+
+            if (!measured)
+                options[optionCount++] = (Strategy){ digits, 1, cutoffs[i] };
+        }
+
+        if (threads > 1)
+        {
+            // Spread batches of whole numbers across threads
+            size_t batches[] = { threads, 4 * threads, 16 * threads };
+            for (size_t i = 0; i < sizeof(batches) / sizeof(batches[0]); i++)
+                options[optionCount++] = (Strategy){ digits, batches[i], NEVER_SPLIT };
+        }
+
+        Strategy best = options[0];
+        double bestTime = -1;
+
+        for (size_t i = 0; i < optionCount; i++)
+        {
+            double time = Measure(options[i], digits, pool);
+
+            if (log != NULL)
+            {
+                fprintf(log, "%zu digits, batch %zu, cutoff ", digits, options[i].Batch);
+                FPrintCutoff(log, options[i].Cutoff);
+                fprintf(log, ": %g s per number\n", time);
+            }
+
+            if (bestTime < 0 || time < bestTime)
+            {
+                best = options[i];
+                bestTime = time;
+            }
+        }
+
+        // The first strategy also covers every digit length smaller than the ones measured
+        if (profile->Count == 0) best.Digits = 1;
+        AddStrategy(profile, best);
+    }
+
+    FreeThreadPool(pool);
+
+    if (profile->Count == 0)
+        AddStrategy(profile, DefaultStrategy(threads, 1));
+
+    return profile;
+}
+
+void FreeTuningProfile(TuningProfile* profile)
+{
+    if (profile == NULL) return;
+    free(profile->Strategies);
+    free(profile);
+}
+
+Strategy FindStrategy(TuningProfile* profile, size_t threads, size_t digits)
+{
+    Strategy strategy = DefaultStrategy(threads, digits);
+    if (profile == NULL) return strategy;
+
+    for (size_t i = 0; i < profile->Count && profile->Strategies[i].Digits <= digits; i++)
+        strategy = profile->Strategies[i];
+
+    return strategy;
+}
+
+void FPrintTuningProfile(FILE* file, TuningProfile* profile)
+{
+    fprintf(file, "%zu\n", profile->Threads);
+
+    for (size_t i = 0; i < profile->Count; i++)
+    {
+        Strategy* strategy = &profile->Strategies[i];
+        fprintf(file, "%zu %zu ", strategy->Digits, strategy->Batch);
+        FPrintCutoff(file, strategy->Cutoff);
+        fprintf(file, "\n");
+    }
+}
+
+TuningProfile* FScanTuningProfile(FILE* file)
+{
+    size_t threads;
+    if (fscanf(file, "%zu", &threads) < 1 || threads == 0) return NULL;
+
+    TuningProfile* profile = malloc(sizeof(TuningProfile));
+    profile->Threads = threads;
+    profile->Count = 0;
+    profile->Strategies = NULL;
+
+    Strategy strategy;
+    char cutoff[32];
+    while (fscanf(file, "%zu %zu %31s", &strategy.Digits, &strategy.Batch, cutoff) == 3)
+    {
+        bool valid = strategy.Batch > 0;
+        if (profile->Count > 0 && strategy.Digits <= profile->Strategies[profile->Count - 1].Digits) valid = false;
+
+        if (strcmp(cutoff, NEVER_SPLIT_TEXT) == 0)
+            strategy.Cutoff = NEVER_SPLIT;
+        else if (sscanf(cutoff, "%zu", &strategy.Cutoff) < 1)
+            valid = false;
+
+        if (!valid)
+        {
+            FreeTuningProfile(profile);
+            return NULL;
+        }
+
+        profile->Strategies = realloc(profile->Strategies, (profile->Count + 1) * sizeof(Strategy));
+        profile->Strategies[profile->Count++] = strategy;
+    }
+
+    if (!feof(file) || profile->Count == 0)
+    {
+        FreeTuningProfile(profile);
+        return NULL;
+    }
+
+    return profile;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The cutoff of strategies that never split the digits of a number into a product tree
+// Written as NEVER_SPLIT_TEXT in tuning profiles and logs
+#define NEVER_SPLIT SIZE_MAX
+#define NEVER_SPLIT_TEXT "-"
+
+// How the numbers of a range of digit lengths should be searched
+typedef struct Strategy
+{
+    // The smallest digit length this strategy applies to
+    size_t Digits;
+
+    // How many numbers are calculated at once, spread across threads
+    // If 1, numbers are calculated one at a time and the threads are used to multiply their digits instead
+    size_t Batch;
+
+    // The size, in digits, below which digits are multiplied sequentially when numbers are
+    // calculated one at a time (see MultiplyDigitsParallel)
+    size_t Cutoff;
+
+} Strategy;
+
+// The best strategies for each digit length, as measured on a specific machine
+typedef struct TuningProfile
+{
+    // The amount of threads the profile was measured with
+    size_t Threads;
+
+    // The amount of strategies in the profile
+    size_t Count;
+
+    // The strategies of the profile, sorted by digit length
+    // Each strategy applies up to the digit length of the next one
+    Strategy* Strategies;
+
+} TuningProfile;
+
+// The largest digit length measured by default when calibrating
+// Reaches a few doublings past DEFAULT_PARALLEL_CUTOFF, where product trees start paying off
+#define DEFAULT_CALIBRATION_DIGITS 32768
+
+// The strategy used for a digit length when there is no tuning profile
+// With several threads, numbers below DEFAULT_PARALLEL_CUTOFF are spread across them in batches, and longer
+// numbers are calculated one at a time with their digits split into a product tree
+Strategy DefaultStrategy(size_t threads, size_t digits);
+
+// Measures every available strategy on the current machine at increasing digit lengths
+// and builds a profile with the fastest one for each digit length
+// threads: The amount of threads that will be used for searching
+// maxDigits: The largest digit length to measure
+// log: A stream to write the progress of the calibration to, or NULL to not write anything
+TuningProfile* Calibrate(size_t threads, size_t maxDigits, FILE* log);
+
+// Frees the memory used by a tuning profile
+void FreeTuningProfile(TuningProfile* profile);
+
+// Gets the strategy that a tuning profile recommends for a digit length
+// Returns the default strategy for the amount of threads if the profile is NULL
+Strategy FindStrategy(TuningProfile* profile, size_t threads, size_t digits);
+
+// Writes a tuning profile to a stream
+void FPrintTuningProfile(FILE* file, TuningProfile* profile);
+
+// Reads a tuning profile from a stream
+// Returns NULL if the reading failed for any reason
+TuningProfile* FScanTuningProfile(FILE* file);